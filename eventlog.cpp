@@ -0,0 +1,143 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#include "eventlog.h"
+
+// -------------------------------------------------------------------------------------------------
+// Each record is 3 bytes:
+//
+//   byte 0 - bits 7..5 the wake reason, bit 4 the charging flag, bits 3..0 the signed battery
+//            percentage delta from the previous record, clamped to -8..7.
+//   byte 1 - whole minutes since the previous record, 0 to 255.
+//   byte 2 - how long we were awake, in tenths of a second, saturating at 25.5s.
+//
+// The encoder tracks the battery level and time as the decoder will reconstruct them, so clamping
+// and rounding errors are carried into the next delta rather than accumulating.
+//
+// Blocks are written round the ring in order, each with the next sequence number.  The newest
+// block is found at boot as the one whose successor doesn't continue the sequence.  Every EEPROM
+// cell is therefore written at most once per trip around the ring.
+// -------------------------------------------------------------------------------------------------
+
+void EventLog::initialise() {
+  static_assert(c_blockCount * c_blockSize == E2END + 1, "Log blocks must fill the EEPROM.");
+
+  auto isValid = [](uint8_t count) { return count >= 1 && count <= c_recordsPerBlock; };
+  auto seqAt = [](uint8_t idx) { return EEPROM.read(idx * c_blockSize); };
+  auto countAt = [](uint8_t idx) { return EEPROM.read(idx * c_blockSize + 1); };
+
+  m_block.count = 0;
+  m_nextBlock = 0;
+  m_nextSeq = 0;
+
+  for (uint8_t idx = 0; idx < c_blockCount; idx++) {
+    if (!isValid(countAt(idx))) {
+      continue;
+    }
+    uint8_t next = (idx + 1) % c_blockCount;
+    if (!isValid(countAt(next)) || seqAt(next) != static_cast<uint8_t>(seqAt(idx) + 1)) {
+      m_nextBlock = next;
+      m_nextSeq = seqAt(idx) + 1;
+      break;
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void EventLog::append(WakeReason reason, bool charging, int16_t batteryPc, uint32_t awakeMs,
+                      uint32_t unixTime) {
+  // Time deltas only go up to 255 minutes.  A longer gap, or the clock being set backwards, starts
+  // a new block with a fresh absolute time.
+  if (m_block.count > 0 && (unixTime < m_lastTime || unixTime - m_lastTime > 255ul * 60)) {
+    flush();
+  }
+
+  if (m_block.count == 0) {
+    m_block.batteryPc = batteryPc;
+    m_block.reserved = 0;
+    m_block.startTime = unixTime;
+    m_lastBatteryPc = batteryPc;
+    m_lastTime = unixTime;
+  }
+
+  int8_t batteryDelta = constrain(batteryPc - m_lastBatteryPc, -8, 7);
+  uint8_t minutes = (unixTime - m_lastTime) / 60;
+  uint8_t awakeTenths = min(awakeMs / 100, 255ul);
+
+  m_lastBatteryPc += batteryDelta;
+  m_lastTime += minutes * 60ul;
+
+  uint8_t* record = &m_block.records[m_block.count * c_recordSize];
+  record[0] = (reason << 5) | (charging ? 0x10 : 0x00) | (batteryDelta & 0x0f);
+  record[1] = minutes;
+  record[2] = awakeTenths;
+
+  if (++m_block.count == c_recordsPerBlock) {
+    flush();
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Write the pending block to the ring.  Only the header and the used records are written, and
+// EEPROM.update() skips cells which already hold the right value.  The sequence number goes last so
+// a write cut short by a reset leaves the previous block as the newest.
+
+void EventLog::flush() {
+  if (m_block.count == 0) {
+    return;
+  }
+
+  m_block.seq = m_nextSeq;
+
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&m_block);
+  int addr = m_nextBlock * c_blockSize;
+  uint8_t len = c_headerSize + m_block.count * c_recordSize;
+  for (uint8_t idx = 1; idx < len; idx++) {
+    EEPROM.update(addr + idx, bytes[idx]);
+  }
+  EEPROM.update(addr, bytes[0]);
+
+  m_nextBlock = (m_nextBlock + 1) % c_blockCount;
+  m_nextSeq++;
+  m_block.count = 0;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Print the whole log, oldest first, as CSV.  Includes the pending records still in RAM.
+
+void EventLog::dump(Print& out) const {
+  out.println(F("time,battery,charging,reason,awakeMs"));
+
+  // The oldest block is the one we'll overwrite next.
+  Block block;
+  for (uint8_t offset = 0; offset < c_blockCount; offset++) {
+    uint8_t idx = (m_nextBlock + offset) % c_blockCount;
+    EEPROM.get(idx * c_blockSize, block);
+    if (block.count >= 1 && block.count <= c_recordsPerBlock) {
+      decodeBlock(block, out);
+    }
+  }
+  decodeBlock(m_block, out);
+}
+
+void EventLog::decodeBlock(const Block& block, Print& out) {
+  int16_t batteryPc = block.batteryPc;
+  uint32_t time = block.startTime;
+
+  for (uint8_t idx = 0; idx < block.count; idx++) {
+    const uint8_t* record = &block.records[idx * c_recordSize];
+
+    // Sign extend the 4 bit battery delta.
+    batteryPc += static_cast<int8_t>(record[0] << 4) >> 4;
+    time += record[1] * 60ul;
+
+    out.print(time);                    out.print(',');
+    out.print(batteryPc);               out.print(',');
+    out.print((record[0] >> 4) & 0x01); out.print(',');
+    out.print(record[0] >> 5);          out.print(',');
+    out.println(record[2] * 100ul);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------------------------------
+// A compact log of battery level and wake events kept in a wear levelled ring of EEPROM blocks.
+//
+// Records are delta encoded against the previous record and batched in RAM, so the EEPROM is only
+// written once a full block of records has been collected.
+
+enum WakeReason : uint8_t {
+  WakeBoot, WakeButton, WakeMotion, WakeOther,
+};
+
+struct EventLog {
+
+  void initialise();
+
+  void append(WakeReason reason, bool charging, int16_t batteryPc, uint32_t awakeMs,
+              uint32_t unixTime);
+  void flush();
+
+  void dump(class Print& out) const;
+
+  private:
+
+  static constexpr uint8_t c_blockSize = 32;
+  static constexpr uint8_t c_recordSize = 3;
+  static constexpr uint8_t c_headerSize = 8;
+  static constexpr uint8_t c_recordsPerBlock = (c_blockSize - c_headerSize) / c_recordSize;
+  static constexpr uint8_t c_blockCount = 32;               // The whole 1KB EEPROM.
+
+  struct Block {
+    uint8_t  seq;                 // Incrementing (and wrapping) sequence number, written last.
+    uint8_t  count;               // Number of records, 1 to c_recordsPerBlock, else unused.
+    uint8_t  batteryPc;           // Absolute battery level the first delta is relative to.
+    uint8_t  reserved;
+    uint32_t startTime;           // Absolute unix time the first delta is relative to.
+    uint8_t  records[c_recordsPerBlock * c_recordSize];
+  };
+  static_assert(sizeof(Block) == c_blockSize, "Log blocks must tile the EEPROM exactly.");
+
+  static void decodeBlock(const Block& block, class Print& out);
+
+  Block    m_block;               // Pending records not yet written to EEPROM.
+  uint8_t  m_nextBlock;           // Ring index the pending block will be written to.
+  uint8_t  m_nextSeq;             // Sequence number the pending block will be written with.
+  int16_t  m_lastBatteryPc;       // Battery level as the decoder will reconstruct it.
+  uint32_t m_lastTime;            // Record time as the decoder will reconstruct it.
+};
+
+// -------------------------------------------------------------------------------------------------
@@ -0,0 +1,98 @@
+#include <Arduino.h>
+
+#include "face-stopwatch.h"
+
+#include "ssd1306.h"
+#include "lines.h"
+
+// -------------------------------------------------------------------------------------------------
+// MM:SS in large digits with the centiseconds small underneath on the right.  Each digit has its
+// own box, aligned to whole display pages, so when it changes we can clear, redraw and flush only
+// that box.  The digits aren't jittered so they can't stray outside their boxes.
+
+namespace {
+
+  struct DigitBox {
+    int8_t left, top, right, bottom;
+  };
+
+  constexpr uint8_t c_numDigits = 6;
+
+  // Minutes, seconds then centiseconds, tens first.  The big digits fill pages 1 to 5 and the small
+  // ones pages 6 and 7.
+  constexpr DigitBox c_digitBoxes[c_numDigits] PROGMEM = {
+    {   4, 10,  24, 45 },
+    {  30, 10,  50, 45 },
+    {  64, 10,  84, 45 },
+    {  90, 10, 110, 45 },
+    {  96, 50, 106, 62 },
+    { 112, 50, 122, 62 },
+  };
+
+  // What's currently on the display, so we know which boxes need redrawing.
+  int8_t g_shownDigits[c_numDigits];
+
+  void getDigits(uint32_t centis, int8_t* digits) {
+    uint16_t seconds = centis / 100;
+    uint8_t minutes = (seconds / 60) % 100;
+    seconds %= 60;
+    centis %= 100;
+
+    digits[0] = minutes / 10;
+    digits[1] = minutes % 10;
+    digits[2] = seconds / 10;
+    digits[3] = seconds % 10;
+    digits[4] = centis / 10;
+    digits[5] = centis % 10;
+  }
+
+  DigitBox getDigitBox(uint8_t idx) {
+    DigitBox box;
+    memcpy_P(&box, &c_digitBoxes[idx], sizeof(DigitBox));
+    return box;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Draw the whole face.
+
+void printStopwatchFace(SSD1306& display, uint32_t centis) {
+  display.clear();
+
+  // The static parts, the colon and the centiseconds point.
+  drawColon(display, 2, 52, 10, 62, 45, false);
+  drawLine(display, 90, 61, 91, 62, false);
+  drawLine(display, 91, 61, 90, 62, false);
+
+  getDigits(centis, g_shownDigits);
+  for (uint8_t idx = 0; idx < c_numDigits; idx++) {
+    DigitBox box = getDigitBox(idx);
+    drawNum(display, g_shownDigits[idx], box.left, box.top, box.right, box.bottom, false);
+  }
+
+  display.flush();
+}
+
+// -------------------------------------------------------------------------------------------------
+// Redraw and flush only the digits which have changed since the last print or update.  Usually
+// that's just the centiseconds, a few dozen bytes rather than the whole 1KB frame.
+
+void updateStopwatchFace(SSD1306& display, uint32_t centis) {
+  int8_t digits[c_numDigits];
+  getDigits(centis, digits);
+
+  for (uint8_t idx = 0; idx < c_numDigits; idx++) {
+    if (digits[idx] == g_shownDigits[idx]) {
+      continue;
+    }
+
+    DigitBox box = getDigitBox(idx);
+    display.clearRegion(box.left, box.right, box.top / 8, box.bottom / 8);
+    drawNum(display, digits[idx], box.left, box.top, box.right, box.bottom, false);
+    display.flushRegion(box.left, box.right, box.top / 8, box.bottom / 8);
+
+    g_shownDigits[idx] = digits[idx];
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
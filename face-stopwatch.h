@@ -0,0 +1,4 @@
+#pragma once
+
+void printStopwatchFace(struct SSD1306& display, uint32_t centis);
+void updateStopwatchFace(struct SSD1306& display, uint32_t centis);
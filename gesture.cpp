@@ -0,0 +1,78 @@
+#include "gesture.h"
+
+// -------------------------------------------------------------------------------------------------
+// A wrist raise is the watch going from lowered (arm hanging or swinging, so the forearm axis takes
+// the gravity, or face down) to steadily face up, within a short window.  Poses in between neither
+// count as lowered nor face up, so jiggling about near face up doesn't look like a fresh raise.
+// Everything is scaled down to 1/64ths of a g first, so it all fits in 8 or 16 bits.
+
+namespace {
+
+  constexpr int8_t c_oneG = 64;
+
+  // Flip if the board is mounted with Z pointing into the wrist.
+  constexpr int8_t c_faceUpSign = 1;
+
+  constexpr int8_t c_faceUpMinZ = (c_oneG * 7) / 10;        // Mostly face up...
+  constexpr int8_t c_faceUpMaxXY = c_oneG / 2;              // ...and not tipped too far.
+  constexpr int8_t c_loweredMinXY = (c_oneG * 6) / 10;      // Mostly on its side or end.
+
+  // Steady means the magnitude is near 1g, i.e., we're not still swinging.  Squared, so 0.8g-1.2g.
+  constexpr uint16_t c_steadyMinSq = (c_oneG * 8 / 10) * (c_oneG * 8 / 10);
+  constexpr uint16_t c_steadyMaxSq = (c_oneG * 12 / 10) * (c_oneG * 12 / 10);
+
+  // Samples are at 20Hz.  The watch must be held face up for 3 (150ms), having not been face up at
+  // most 30 (1.5s) ago.
+  constexpr uint8_t c_holdSamples = 3;
+  constexpr uint8_t c_raiseWindowSamples = 30;
+
+  int8_t scale(int16_t raw) {
+    return raw >> 8;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void WristRaiseClassifier::reset() {
+  m_samplesSinceLowered = 0xff;
+  m_faceUpCount = 0;
+}
+
+bool WristRaiseClassifier::feed(const AccelSample& sample) {
+  int16_t x = scale(sample.x);
+  int16_t y = scale(sample.y);
+  int16_t z = scale(sample.z) * c_faceUpSign;
+
+  uint16_t magnitudeSq = static_cast<uint16_t>(x * x) + static_cast<uint16_t>(y * y)
+                       + static_cast<uint16_t>(z * z);
+  bool steady = magnitudeSq >= c_steadyMinSq && magnitudeSq <= c_steadyMaxSq;
+  bool faceUp = z >= c_faceUpMinZ && x <= c_faceUpMaxXY && x >= -c_faceUpMaxXY
+                                  && y <= c_faceUpMaxXY && y >= -c_faceUpMaxXY;
+
+  bool lowered = z < 0 || x >= c_loweredMinXY || x <= -c_loweredMinXY
+                        || y >= c_loweredMinXY || y <= -c_loweredMinXY;
+
+  if (lowered) {
+    m_samplesSinceLowered = 0;
+    m_faceUpCount = 0;
+    return false;
+  }
+
+  if (m_samplesSinceLowered != 0xff) {
+    m_samplesSinceLowered++;
+  }
+  if (!faceUp) {
+    m_faceUpCount = 0;
+    return false;
+  }
+  m_faceUpCount = steady ? m_faceUpCount + 1 : 0;
+
+  if (m_faceUpCount >= c_holdSamples && m_samplesSinceLowered <= c_raiseWindowSamples) {
+    // Only once per raise, it must be lowered again before the next.
+    m_samplesSinceLowered = 0xff;
+    return true;
+  }
+  return false;
+}
+
+// -------------------------------------------------------------------------------------------------
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------------------------------
+// A wrist raise classifier over accelerometer samples, in fixed point.  It has no hardware
+// dependencies, so recorded traces can be replayed through it off the watch.
+
+struct AccelSample {
+  int16_t x, y, z;                    // Raw at +/-2g full scale, i.e., 16384 per g.
+};
+
+struct WristRaiseClassifier {
+
+  void reset();
+
+  // Feed the next sample, returns true on the sample where a wrist raise is recognised.
+  bool feed(const AccelSample& sample);
+
+  private:
+
+  uint8_t m_samplesSinceLowered;      // Samples since the watch wasn't face up, saturating.
+  uint8_t m_faceUpCount;              // Consecutive steady, face up samples.
+};
+
+// -------------------------------------------------------------------------------------------------
@@ -0,0 +1,93 @@
+#include <Arduino.h>
+
+#include <util/atomic.h>
+
+#include "memory.h"
+
+// -------------------------------------------------------------------------------------------------
+// Provided by the linker and the avr-libc malloc().
+
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t __heap_start;
+extern char* __brkval;
+
+namespace {
+
+  constexpr uint8_t c_canary = 0xc5;
+
+  uint16_t g_lastStackDepth = 0;
+  uint16_t g_maxStackDepth = 0;
+
+  uint8_t* getHeapTop() {
+    return __brkval != nullptr ? reinterpret_cast<uint8_t*>(__brkval) : &__heap_start;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Paint free SRAM before main() runs.  This goes in .init3, after the stack pointer and the zero
+// register are set up but before .bss is cleared or any constructors run, so nothing but the return
+// into main() is on the stack.
+
+void paintStack() __attribute__((naked, used, section(".init3")));
+
+void paintStack() {
+  for (uint8_t* addr = &_end; addr <= &__stack; addr++) {
+    *addr = c_canary;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+uint16_t getStaticRam() {
+  return &__heap_start - reinterpret_cast<uint8_t*>(RAMSTART);
+}
+
+uint16_t getFreeRam() {
+  return reinterpret_cast<uint8_t*>(SP) - getHeapTop();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void sampleStack() {
+  uint8_t* heapTop = getHeapTop();
+  uint8_t* stackTop = reinterpret_cast<uint8_t*>(SP);
+
+  // The first byte up from the heap which isn't paint is the deepest the stack has been.
+  uint8_t* addr = heapTop;
+  while (addr < stackTop && *addr == c_canary) {
+    addr++;
+  }
+  g_lastStackDepth = &__stack - addr + 1;
+  g_maxStackDepth = max(g_maxStackDepth, g_lastStackDepth);
+
+  // Repaint below the current stack.  An interrupt would push its frame into the area we're
+  // painting so they're held off until we're done.
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    stackTop = reinterpret_cast<uint8_t*>(SP);
+    for (addr = heapTop; addr < stackTop; addr++) {
+      *addr = c_canary;
+    }
+  }
+}
+
+uint16_t getLastStackDepth() {
+  return g_lastStackDepth;
+}
+
+uint16_t getMaxStackDepth() {
+  return g_maxStackDepth;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void printMemoryReport(Print& out) {
+  out.print(F("ram: static "));   out.print(getStaticRam());
+  out.print(F(", free "));        out.print(getFreeRam());
+  out.print(F(", stack max "));   out.print(getMaxStackDepth());
+  out.print(F(", stack last "));  out.print(getLastStackDepth());
+  out.print(F(", margin "));
+  out.println(static_cast<int16_t>(&__stack + 1 - getHeapTop() - getMaxStackDepth()));
+}
+
+// -------------------------------------------------------------------------------------------------
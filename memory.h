@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------------------------------
+// SRAM usage.  Everything between the end of the static data and the stack is painted with a canary
+// at boot, so we can see how deep the stack has reached by how much of the paint is gone.
+
+uint16_t getStaticRam();
+uint16_t getFreeRam();
+
+// Measure the deepest the stack has reached since the last sample, fold it into the maximum, and
+// repaint.  Call at quiet points, e.g., after a frame or before sleeping.
+void sampleStack();
+
+uint16_t getLastStackDepth();
+uint16_t getMaxStackDepth();
+
+void printMemoryReport(class Print& out);
+
+// -------------------------------------------------------------------------------------------------
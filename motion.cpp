@@ -0,0 +1,200 @@
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "motion.h"
+
+#include "gesture.h"
+#include "power.h"
+
+// -------------------------------------------------------------------------------------------------
+// Search for the MPU-6000/MPU-6050 'Register Map and Descriptions' from InvenSense.
+//
+// The accelerometer runs alone in its low power cycle mode at 20Hz with the gyros in standby, and
+// raises its interrupt when it sees motion.  That wakes us and starts a capture: the FIFO is reset
+// and we go back to sleep, woken every 250ms by the watchdog to read the 5 or so new samples in a
+// single I2C burst and run them through the classifier.  The capture ends on a wrist raise or after
+// a second, and we're left asleep until the next motion.
+// -------------------------------------------------------------------------------------------------
+
+namespace {
+
+  constexpr uint8_t c_imuAddress = 0x69;      // AD0 is pulled high.
+  constexpr int8_t  c_imuIntPin = 7;          // INT6.
+
+  constexpr uint8_t c_regMotionThreshold = 0x1f;
+  constexpr uint8_t c_regMotionDuration  = 0x20;
+  constexpr uint8_t c_regAccelConfig     = 0x1c;
+  constexpr uint8_t c_regFifoEnable      = 0x23;
+  constexpr uint8_t c_regIntPinConfig    = 0x37;
+  constexpr uint8_t c_regIntEnable       = 0x38;
+  constexpr uint8_t c_regIntStatus       = 0x3a;
+  constexpr uint8_t c_regUserCtrl        = 0x6a;
+  constexpr uint8_t c_regPowerMgmt1      = 0x6b;
+  constexpr uint8_t c_regPowerMgmt2      = 0x6c;
+  constexpr uint8_t c_regFifoCountH      = 0x72;
+  constexpr uint8_t c_regFifoReadWrite   = 0x74;
+
+  constexpr uint8_t c_accel2gHpf5Hz      = 0x01;  // +/-2g, 5Hz high pass on the motion detector.
+  constexpr uint8_t c_accelFifoEnable    = 0x08;
+  constexpr uint8_t c_intActiveLowLatch  = 0xa0;  // Held low until INT_STATUS is read.
+  constexpr uint8_t c_intMotionEnable    = 0x40;
+  constexpr uint8_t c_userFifoEnable     = 0x40;
+  constexpr uint8_t c_userFifoReset      = 0x04;
+  constexpr uint8_t c_powerReset         = 0x80;
+  constexpr uint8_t c_powerCycleNoTemp   = 0x28;
+  constexpr uint8_t c_powerWake20HzAccel = 0x87;  // LP_WAKE_CTRL 20Hz, gyros in standby.
+
+  constexpr uint8_t c_motionThreshold = 10;
+  constexpr uint8_t c_motionDuration = 1;
+
+  constexpr uint8_t c_sampleBytes = 6;
+  constexpr uint8_t c_maxBurstSamples = BUFFER_LENGTH / c_sampleBytes;
+
+  constexpr uint8_t c_captureWindows = 4;       // 4 x 250ms.
+
+  // -----------------------------------------------------------------------------------------------
+
+  volatile bool g_motionDetected = false;
+  uint8_t g_captureWindowsLeft = 0;
+
+  WristRaiseClassifier g_classifier;
+
+  // -----------------------------------------------------------------------------------------------
+  // Only a level interrupt on INT6 can wake us from power down, so the ISR has to mask itself until
+  // the IMU's latched interrupt has been cleared.
+
+  void motionIsr() {
+    EIMSK &= ~bit(INT6);
+    g_motionDetected = true;
+  }
+
+  void rearmMotionInterrupt() {
+    EIFR = bit(INTF6);
+    EIMSK |= bit(INT6);
+  }
+
+  // -----------------------------------------------------------------------------------------------
+
+  void writeReg(uint8_t reg, uint8_t value) {
+    Wire.beginTransmission(c_imuAddress);
+    Wire.write(reg);
+    Wire.write(value);
+    Wire.endTransmission();
+  }
+
+  void readRegs(uint8_t reg, uint8_t len) {
+    Wire.beginTransmission(c_imuAddress);
+    Wire.write(reg);
+    Wire.endTransmission(false);
+    Wire.requestFrom(c_imuAddress, len);
+  }
+
+  uint8_t readReg(uint8_t reg) {
+    readRegs(reg, 1);
+    return Wire.read();
+  }
+
+  int16_t readInt16() {
+    int16_t high = Wire.read();
+    return (high << 8) | Wire.read();
+  }
+
+  // -----------------------------------------------------------------------------------------------
+  // Read as many whole samples as are waiting, up to what fits in the Wire buffer, in one burst.
+  // Any more are left for the next window.
+
+  uint8_t readFifo(AccelSample* samples) {
+    readRegs(c_regFifoCountH, 2);
+    uint16_t count = readInt16() / c_sampleBytes;
+    uint8_t numSamples = min(count, c_maxBurstSamples);
+    if (numSamples == 0) {
+      return 0;
+    }
+
+    readRegs(c_regFifoReadWrite, numSamples * c_sampleBytes);
+    for (uint8_t idx = 0; idx < numSamples; idx++) {
+      samples[idx].x = readInt16();
+      samples[idx].y = readInt16();
+      samples[idx].z = readInt16();
+    }
+    return numSamples;
+  }
+
+  // -----------------------------------------------------------------------------------------------
+
+  void startCapture() {
+    writeReg(c_regUserCtrl, c_userFifoReset);
+    writeReg(c_regUserCtrl, c_userFifoEnable);
+    g_classifier.reset();
+    g_captureWindowsLeft = c_captureWindows;
+    g_power.startWakeTimer();
+  }
+
+  void stopCapture() {
+    g_power.stopWakeTimer();
+    writeReg(c_regUserCtrl, 0);
+    g_captureWindowsLeft = 0;
+
+    // Clear whatever motion happened during the capture and wait for the next.
+    readReg(c_regIntStatus);
+    g_motionDetected = false;
+    rearmMotionInterrupt();
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void initialiseMotion() {
+  writeReg(c_regPowerMgmt1, c_powerReset);
+  delay(100);
+
+  writeReg(c_regAccelConfig, c_accel2gHpf5Hz);
+  writeReg(c_regMotionThreshold, c_motionThreshold);
+  writeReg(c_regMotionDuration, c_motionDuration);
+  writeReg(c_regFifoEnable, c_accelFifoEnable);
+  writeReg(c_regIntPinConfig, c_intActiveLowLatch);
+  writeReg(c_regIntEnable, c_intMotionEnable);
+  writeReg(c_regPowerMgmt2, c_powerWake20HzAccel);
+  writeReg(c_regPowerMgmt1, c_powerCycleNoTemp);
+  readReg(c_regIntStatus);
+
+  pinMode(c_imuIntPin, INPUT);
+  attachInterrupt(digitalPinToInterrupt(c_imuIntPin), motionIsr, LOW);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool updateMotion() {
+  if (g_motionDetected) {
+    g_motionDetected = false;
+    g_power.require(PeriphTwi);
+
+    // The interrupt stays masked for the whole capture, its windows come from the wake timer.
+    readReg(c_regIntStatus);
+    startCapture();
+  }
+
+  if (g_captureWindowsLeft == 0 || !g_power.takeWakeTimer()) {
+    return false;
+  }
+
+  g_power.require(PeriphTwi);
+  AccelSample samples[c_maxBurstSamples];
+  uint8_t numSamples = readFifo(samples);
+
+  bool raised = false;
+  for (uint8_t idx = 0; idx < numSamples && !raised; idx++) {
+    raised = g_classifier.feed(samples[idx]);
+  }
+
+  if (raised || --g_captureWindowsLeft == 0) {
+    stopCapture();
+  }
+  return raised;
+}
+
+bool isMotionPending() {
+  return g_motionDetected;
+}
+
+// -------------------------------------------------------------------------------------------------
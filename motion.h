@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------------------------------
+// Wake on motion from the MPU-6050, and wrist raise detection over the samples which follow.
+
+void initialiseMotion();
+
+// Handle any pending motion interrupt or capture window.  Returns true when a wrist raise is seen.
+bool updateMotion();
+
+// Whether there's a motion interrupt waiting for updateMotion().
+bool isMotionPending();
+
+// -------------------------------------------------------------------------------------------------
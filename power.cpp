@@ -0,0 +1,175 @@
+#include <Arduino.h>
+
+#include <avr/power.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+#include "power.h"
+
+// -------------------------------------------------------------------------------------------------
+
+PowerManager g_power;
+
+namespace {
+
+  volatile bool g_wakeTimerFired = false;
+}
+
+ISR(WDT_vect) {
+  g_wakeTimerFired = true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void PowerManager::initialise() {
+  // Everything is clocked after a reset.
+  m_enabled = 0xff;
+
+  // The analog comparator is never used, and isn't covered by the power reduction registers.
+  ACSR |= bit(ACD);
+
+  // Nothing uses the hardware serial port or the PWM timers yet.
+  disable(PeriphUsart1 | PeriphTimer1 | PeriphTimer4);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Gate everything we can and power down until an interrupt wakes us.  Peripherals stay gated after
+// the wake until someone require()s them.
+
+void PowerManager::sleep(bool (*hasPendingWork)()) {
+  // We keep USB running while there's power from it so the serial connection survives.
+  uint8_t gated = m_enabled;
+  if ((USBSTA & bit(VBUS)) != 0) {
+    gated &= ~PeriphUsb;
+  }
+  disable(gated);
+
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  cli();
+
+  // An interrupt may have fired since the caller last checked its flags.  Edge triggered sources
+  // like the RTC alarm won't fire again until they're handled, so we mustn't sleep through them.
+  if (g_wakeTimerFired || hasPendingWork()) {
+    sei();
+    return;
+  }
+
+  sleep_enable();
+#if defined(BODS)
+  // Only on parts with software BOD control.  On the 32U4 the BOD is set by the fuses alone, and it
+  // must stay enabled.  The event log writes EEPROM while running and a flat cell can corrupt it.
+  sleep_bod_disable();
+#endif
+
+  // Interrupts are only taken after the instruction following sei(), so one can't land between the
+  // check above and sleeping.
+  sei();
+  sleep_cpu();
+
+  // ... wake.
+  sleep_disable();
+}
+
+// -------------------------------------------------------------------------------------------------
+// Stop the CPU until the next interrupt, leaving everything else running.  For when we're awake but
+// waiting on a timer.
+
+void PowerManager::idle() {
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_mode();
+}
+
+// -------------------------------------------------------------------------------------------------
+// The watchdog keeps running in power down, so in interrupt only mode it makes a cheap periodic
+// wake.  Changing its settings needs the timed WDCE sequence.
+
+void PowerManager::startWakeTimer() {
+  g_wakeTimerFired = false;
+  cli();
+  wdt_reset();
+  WDTCSR = bit(WDCE) | bit(WDE);
+  WDTCSR = bit(WDIE) | bit(WDP2);
+  sei();
+}
+
+void PowerManager::stopWakeTimer() {
+  cli();
+  wdt_reset();
+  MCUSR &= ~bit(WDRF);
+  WDTCSR = bit(WDCE) | bit(WDE);
+  WDTCSR = 0;
+  sei();
+  g_wakeTimerFired = false;
+}
+
+bool PowerManager::takeWakeTimer() {
+  if (!g_wakeTimerFired) {
+    return false;
+  }
+  g_wakeTimerFired = false;
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void PowerManager::enable(uint8_t peripherals) {
+  if (peripherals & PeriphAdc) {
+    power_adc_enable();
+    ADCSRA |= bit(ADEN);
+  }
+  if (peripherals & PeriphSpi) {
+    // The datasheet says to re-initialise SPI and TWI after they've been gated.
+    power_spi_enable();
+    SPCR = m_spcr;
+    SPSR = m_spsr;
+  }
+  if (peripherals & PeriphTwi) {
+    power_twi_enable();
+    TWBR = m_twbr;
+    TWCR = m_twcr;
+  }
+  if (peripherals & PeriphUsart1) { power_usart1_enable(); }
+  if (peripherals & PeriphTimer1) { power_timer1_enable(); }
+  if (peripherals & PeriphTimer4) { power_timer4_enable(); }
+  if (peripherals & PeriphUsb) {
+    // Restart the PLL and unfreeze the USB clock, as for resuming from USB suspend.
+    PLLCSR |= bit(PLLE);
+    while ((PLLCSR & bit(PLOCK)) == 0) {
+    }
+    USBCON &= ~bit(FRZCLK);
+  }
+
+  m_enabled |= peripherals;
+}
+
+void PowerManager::disable(uint8_t peripherals) {
+  if (peripherals & PeriphAdc) {
+    // The ADC must be switched off before it's gated or it keeps drawing current.
+    ADCSRA &= ~bit(ADEN);
+    power_adc_disable();
+  }
+  if (peripherals & PeriphSpi) {
+    m_spcr = SPCR;
+    m_spsr = SPSR & bit(SPI2X);
+    power_spi_disable();
+  }
+  if (peripherals & PeriphTwi) {
+    // Only the settings Wire leaves, not the flags or a pending start or stop.
+    m_twbr = TWBR;
+    m_twcr = TWCR & (bit(TWEN) | bit(TWIE) | bit(TWEA));
+    power_twi_disable();
+  }
+  if (peripherals & PeriphUsart1) { power_usart1_disable(); }
+  if (peripherals & PeriphTimer1) { power_timer1_disable(); }
+  if (peripherals & PeriphTimer4) { power_timer4_disable(); }
+  if (peripherals & PeriphUsb) {
+    // Freeze the USB clock and stop the PLL rather than gating the whole USB controller.  This way
+    // VBUS can still be read from USBSTA, and we needn't re-enumerate when it's enabled again.
+    USBCON |= bit(FRZCLK);
+    PLLCSR &= ~bit(PLLE);
+  }
+
+  m_enabled &= ~peripherals;
+}
+
+// -------------------------------------------------------------------------------------------------
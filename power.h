@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------------------------------
+// The peripherals we can clock gate.  Everything is gated while we sleep and each is brought back
+// only when something first uses it after a wake, so a wake pays for just what its path needs.
+//
+// Timer0 and Timer3 aren't listed and are never gated, as millis(), delay() and tone() use them
+// without asking.
+
+enum Peripheral : uint8_t {
+  PeriphAdc    = 1 << 0,
+  PeriphSpi    = 1 << 1,
+  PeriphTwi    = 1 << 2,
+  PeriphUsb    = 1 << 3,
+  PeriphUsart1 = 1 << 4,
+  PeriphTimer1 = 1 << 5,
+  PeriphTimer4 = 1 << 6,
+};
+
+struct PowerManager {
+
+  void initialise();
+
+  // Make sure the peripherals are powered, enabling any which aren't.  Cheap when they already are.
+  void require(uint8_t peripherals) {
+    if ((m_enabled & peripherals) != peripherals) {
+      enable(peripherals & ~m_enabled);
+    }
+  }
+
+  // Power down until an interrupt, unless hasPendingWork() says an interrupt has already left us
+  // something to do.  It's called with interrupts off, so nothing can slip in before we sleep.
+  void sleep(bool (*hasPendingWork)());
+  void idle();
+
+  // The watchdog as a timer which wakes us from sleep every 250ms, until stopped.
+  void startWakeTimer();
+  void stopWakeTimer();
+  bool takeWakeTimer();
+
+  uint8_t getEnabled() const { return m_enabled; }
+
+  private:
+
+  void enable(uint8_t peripherals);
+  void disable(uint8_t peripherals);
+
+  uint8_t m_enabled;
+
+  // SPI and TWI settings, restored when they're enabled again.
+  uint8_t m_spcr;
+  uint8_t m_spsr;
+  uint8_t m_twcr;
+  uint8_t m_twbr;
+};
+
+extern PowerManager g_power;
+
+// -------------------------------------------------------------------------------------------------
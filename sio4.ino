@@ -2,14 +2,17 @@
 
 #include <Wire.h>
 
-#include <avr/power.h>
-#include <avr/sleep.h>
-
 #include "RTClib.h"
 #include <YetAnotherPcInt.h>
 
 #include "ssd1306.h"
+#include "eventlog.h"
+#include "memory.h"
+#include "motion.h"
+#include "power.h"
 #include "face-lines.h"
+#include "face-stopwatch.h"
+#include "stopwatch.h"
 #include "lines.h"
 
 RTC_DS3231 rtc;
@@ -33,14 +36,23 @@ constexpr int8_t c_rtcAlarmPin = 1;
 constexpr int8_t c_buzzerPin = 9;
 
 constexpr uint32_t c_showTimeTimeoutMs = 4000;
+constexpr uint32_t c_buttonDebounceMs = 50;
 
 // -------------------------------------------------------------------------------------------------
 // Button state and interrupt handlers.
 
-//volatile bool g_upperLeftButtonPressed = false;
-//volatile bool g_upperRightButtonPressed = false;
+volatile bool g_upperLeftButtonPressed = false;
+volatile bool g_upperRightButtonPressed = false;
 volatile bool g_lowerRightButtonPressed = false;
 
+void buttonUlbIsr(bool ) {
+  g_upperLeftButtonPressed = true;
+}
+
+void buttonUrbIsr(bool ) {
+  g_upperRightButtonPressed = true;
+}
+
 void buttonLrbIsr(bool ) {
   g_lowerRightButtonPressed = true;
 }
@@ -58,11 +70,13 @@ void rtcAlarmIsr() {
 // Global instances.
 
 SSD1306  g_display;
+EventLog g_eventLog;
 
 
 // -------------------------------------------------------------------------------------------------
 
 void setup() {
+  g_power.initialise();
   Wire.begin();
   rtc.begin();
   int year = {0};
@@ -92,10 +106,15 @@ pinMode(c_rtcAlarmPin, INPUT_PULLUP);
 // Enable USB VBUS pad so we can read the power state from the USB status register.
 USBCON |= bit(OTGPADE);
 
-// Install an ISR for LRB and alarm.
+// Install an ISR for each button and the alarm.
+PcInt::attachInterrupt(c_upperLeftButtonPin, buttonUlbIsr, FALLING);
+PcInt::attachInterrupt(c_upperRightButtonPin, buttonUrbIsr, FALLING);
 PcInt::attachInterrupt(c_lowerRightButtonPin, buttonLrbIsr, FALLING);
 attachInterrupt(digitalPinToInterrupt(c_rtcAlarmPin), rtcAlarmIsr, FALLING);
 
+// Set up the IMU to wake us on motion.
+initialiseMotion();
+
 // Init the RTC.
 //  g_rtc.set_model(URTCLIB_MODEL_DS3231);
 
@@ -103,6 +122,17 @@ attachInterrupt(digitalPinToInterrupt(c_rtcAlarmPin), rtcAlarmIsr, FALLING);
 //  g_rtc.alarmClearFlag(URTCLIB_ALARM_1);
 //  g_rtc.alarmSet(URTCLIB_ALARM_TYPE_1_FIXED_MS, 0, 0, 0, 0);
 
+// Alarm 2 is every minute on the minute, so the frame waiting in the display stays current.
+rtc.disableAlarm(1);
+rtc.clearAlarm(1);
+rtc.clearAlarm(2);
+rtc.writeSqwPinMode(DS3231_OFF);
+rtc.setAlarm2(rtc.now(), DS3231_A2_PerMinute);
+
+// Find where the event log left off.
+g_eventLog.initialise();
+getBatteryPc();
+
 // Init the display.
 g_display.initialise();
 g_display.clear();
@@ -115,27 +145,39 @@ if (getUsbAttached()) {
 
 // -------------------------------------------------------------------------------------------------
 
+bool g_frameStale = true;             // Is the display RAM not holding the time face for now?
+
 void powerDown() {
-  // Power down everything.
+  // Power down everything.  The power manager brings peripherals back as they're next used, and the
+  // display is only turned on again once there's something to show.
   g_display.turnOff();
-  power_adc_disable();
-  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
-  sleep_enable();
 
-  // Sleep.
-  sleep_cpu();
+  // The display keeps its RAM while it's off, so get the frame the next wake will show ready now.
+  if (g_frameStale) {
+    preRenderTime();
+  }
+
+  g_power.sleep(hasPendingWork);
+}
 
-  // ... wake.
+// Whether any interrupt has set a flag which loop() hasn't handled yet.
+bool hasPendingWork() {
+  return g_isAlarmed
+      || g_lowerRightButtonPressed || g_upperRightButtonPressed || g_upperLeftButtonPressed
+      || isMotionPending();
+}
+
+// -------------------------------------------------------------------------------------------------
 
-  // Power up.
-  sleep_disable();
-  power_adc_enable();
-  g_display.turnOn();
+DateTime getNow() {
+  g_power.require(PeriphTwi);
+  return rtc.now();
 }
 
 // -------------------------------------------------------------------------------------------------
 
 float getRawBattery() {
+  g_power.require(PeriphAdc);
   digitalWrite(c_batteryReadEnablePin, HIGH);
   delay(50);
   float value = analogRead(c_batteryPin);
@@ -143,14 +185,22 @@ float getRawBattery() {
   return value;
 }
 
+int16_t g_lastBatteryPc = 0;         // The most recent reading, kept for the event log.
+
 int16_t getBatteryPc() {
   int16_t rawLevel = static_cast<int16_t>(getRawBattery());
-  return max(0, min(100, rawLevel - 534));
+  g_lastBatteryPc = max(0, min(100, rawLevel - 534));
+  return g_lastBatteryPc;
 }
 
 bool getUsbAttached() {
   // We can test if a USB data connection is up; UDADDR is the USB address register, and the ADDEN
-  // bit is whether the address is enabled.
+  // bit is whether the address is enabled.  It can't be read while the USB clock is frozen, so
+  // check for power first to avoid waking USB needlessly.
+  if (!getUsbPowered()) {
+    return false;
+  }
+  g_power.require(PeriphUsb);
   return (UDADDR & bit(ADDEN)) != 0;
 }
 
@@ -165,6 +215,19 @@ bool getCharging() {
   return getUsbPowered() && digitalRead(c_chargingPin) == LOW;
 }
 
+// -------------------------------------------------------------------------------------------------
+// Render the time face and upload it while the display is off, so a wake can just turn it on.  We
+// use the last battery reading rather than spend 50ms taking a new one.
+
+void preRenderTime() {
+  DateTime now = getNow();
+  printLinesFace(g_display,
+                 now.month(), now.day(), now.hour(), now.minute(), now.second(),
+                 now.dayOfTheWeek(),
+                 g_lastBatteryPc);
+  g_frameStale = false;
+}
+
 // -------------------------------------------------------------------------------------------------
 // Read the date and time values from the serial port.  Useful for booting after reset.  Will prompt
 // for the correct values (year, month, day, etc.) one after the other.
@@ -226,6 +289,29 @@ bool readDateTimeFromSerial() {
   Serial.end();
 }
 
+// -------------------------------------------------------------------------------------------------
+// Stream the event log and memory report out over serial, once per USB connection.  We wait until a
+// terminal has actually opened the port, otherwise the output would just be dropped.
+
+bool g_serialDumped = false;
+
+void dumpToSerial() {
+  if (!getUsbAttached()) {
+    g_serialDumped = false;
+    return;
+  }
+  if (g_serialDumped) {
+    return;
+  }
+
+  Serial.begin(9600);
+  if (Serial) {
+    g_eventLog.dump(Serial);
+    printMemoryReport(Serial);
+    g_serialDumped = true;
+  }
+}
+
 // -------------------------------------------------------------------------------------------------
 // Here's a dumb check for elapsed time, checking if a millis() value has passed but accounting for
 // overflow.
@@ -247,28 +333,112 @@ bool hasElapsed(uint32_t nowMillis, uint32_t futureMillis) {
 // -------------------------------------------------------------------------------------------------
 // Generally we just sleep to save power.
 //
-// We can wake for two reasons:
+// We can wake for these reasons:
 // - A lower right button press for which we show the time.
+// - Motion, after which we watch for a wrist raise and show the time for that too.
+// - An upper right button press which shows the stopwatch, or starts and stops it once shown.  The
+//   upper left button stops and resets it.  We stay awake while it's running.
+// - An on the minute alarm for which we pre-render the next frame.
 // - An on the hour alarm for which we beep.
 
 bool g_showingTime = false;           // Are we currently awake and showing the time?
 bool g_refreshTime = false;           // Whether to refresh the display with the time.
 uint32_t g_stopShowingTime = 0;       // When do we next turn it off and go back to sleep?
+bool g_showingStopwatch = false;      // Is the stopwatch on the display rather than the time?
+uint32_t g_upperButtonsSettled = 0;   // When do we stop ignoring upper button bounce?
+
+WakeReason g_wakeReason = WakeBoot;   // Why we woke, for the event log.
+uint32_t g_wakeMillis = 0;            // When we woke, for the event log.
 
 void loop() {
-  DateTime now = rtc.now();
+  // The display already holds the time face, so turning it on shows the time straight away.  Do it
+  // before anything else, e.g., a press usually trips the motion interrupt too and that costs I2C
+  // transactions.  The refresh below then updates it with the battery level and the current time.
+  if (g_lowerRightButtonPressed && !g_showingTime && !g_frameStale) {
+    g_display.turnOn();
+  }
+
   uint32_t nowMillis = millis();
 
+  // A wrist raise is the same as pressing the lower right button, unless we're already showing
+  // something.
+  bool wristRaised = updateMotion() && !g_showingTime;
+
   // Check our global flags which may be set by interrupts.
-  if (g_lowerRightButtonPressed) {
+  if (g_isAlarmed) {
+    // Acknowledge and clear.
+    g_power.require(PeriphTwi);
+    rtc.clearAlarm(2);
+    g_isAlarmed = false;
+
+    // The minute has changed.  Redraw now if the time is showing, otherwise before we sleep again.
+    // These wakes aren't logged, once a minute would swamp the log.
+    g_frameStale = true;
+    if (g_showingTime && !g_showingStopwatch) {
+      g_refreshTime = true;
+    }
+  }
+  if (g_lowerRightButtonPressed || wristRaised) {
     // Acknowledge and clear.
     g_lowerRightButtonPressed = false;
+    g_wakeReason = wristRaised ? WakeMotion : WakeButton;
+
+    // A wrist raise lights the pre-rendered frame as the button does above.
+    if (wristRaised && !g_frameStale) {
+      g_display.turnOn();
+    }
 
     // Show the time.
+    stopStopwatch();
+    g_showingStopwatch = false;
     g_showingTime = true;
     g_refreshTime = true;
     g_stopShowingTime = nowMillis + c_showTimeTimeoutMs;
   }
+
+  // The upper buttons toggle the stopwatch, so contact bounce just after a press is ignored.  This
+  // can use millis() as the bounce comes while we're still awake handling the press.
+  bool upperRightPressed = g_upperRightButtonPressed;
+  bool upperLeftPressed = g_upperLeftButtonPressed;
+  g_upperRightButtonPressed = false;
+  g_upperLeftButtonPressed = false;
+  if (!hasElapsed(nowMillis, g_upperButtonsSettled)) {
+    upperRightPressed = false;
+    upperLeftPressed = false;
+  }
+  if (upperRightPressed || upperLeftPressed) {
+    g_upperButtonsSettled = nowMillis + c_buttonDebounceMs;
+  }
+
+  if (upperRightPressed) {
+    g_wakeReason = WakeButton;
+
+    if (!g_showingStopwatch) {
+      // Show the stopwatch, ready to go.
+      resetStopwatch();
+      printStopwatchFace(g_display, 0);
+      g_frameStale = true;
+      g_display.turnOn();
+      g_showingStopwatch = true;
+    } else if (isStopwatchRunning()) {
+      stopStopwatch();
+      updateStopwatchFace(g_display, getStopwatchCentis());
+    } else {
+      startStopwatch();
+    }
+    g_showingTime = true;
+    g_stopShowingTime = nowMillis + c_showTimeTimeoutMs;
+  }
+  if (upperLeftPressed) {
+    g_wakeReason = WakeButton;
+
+    if (g_showingStopwatch) {
+      stopStopwatch();
+      resetStopwatch();
+      updateStopwatchFace(g_display, 0);
+      g_stopShowingTime = nowMillis + c_showTimeTimeoutMs;
+    }
+  }
   //  if (g_isAlarmed) {
   //    // Acknowledge and clear.
   //    g_rtc.alarmClearFlag(URTCLIB_ALARM_1);
@@ -287,21 +457,48 @@ void loop() {
 
   // Show the time if required.
     if (g_refreshTime) {
-      
+      DateTime now = getNow();
       printLinesFace(g_display,
                      now.month(), now.day(), now.hour(), now.minute(), now.second(),
                     now.dayOfTheWeek(),
                      getBatteryPc());
+      g_display.turnOn();
       g_refreshTime = false;
+      g_frameStale = false;
     }
 
+  // Keep the stopwatch ticking over.  Only the changed digits are redrawn and sent, at the frame
+  // rate set by its timer.  We don't time out while it's running.
+  if (isStopwatchRunning()) {
+    if (takeStopwatchFrame()) {
+      updateStopwatchFace(g_display, getStopwatchCentis());
+    }
+    g_stopShowingTime = nowMillis + c_showTimeTimeoutMs;
+  }
+
   if (hasElapsed(nowMillis, g_stopShowingTime)) {
     g_showingTime = false;
+    g_showingStopwatch = false;
   }
 
   if (!g_showingTime) {
+    dumpToSerial();
+
+    // Log the wake before we sleep.  Wakes we didn't act on (e.g., USB interrupts) would swamp the
+    // log so they're left out.  The stack sample covers everything this wake did, including frames.
+    if (g_wakeReason != WakeOther) {
+      sampleStack();
+      g_eventLog.append(g_wakeReason, getCharging(), g_lastBatteryPc, millis() - g_wakeMillis,
+                        getNow().unixtime());
+    }
+
     // We're not busy doing anything else, go to sleep.
     powerDown();
+    g_wakeReason = WakeOther;
+    g_wakeMillis = millis();
+  } else if (isStopwatchRunning()) {
+    // Wait for the next tick.
+    g_power.idle();
   }
 }
 
@@ -2,6 +2,8 @@
 
 #include <SPI.h>
 
+#include "power.h"
+
 // -------------------------------------------------------------------------------------------------
 // Search for the SSD1306.pdf 'Advance Information' from Solomon Systech.
 // -------------------------------------------------------------------------------------------------
@@ -33,6 +35,8 @@ namespace {
   constexpr int8_t c_horizMode          = 0x00;
   constexpr int8_t c_vertMode           = 0x01;
   constexpr int8_t c_pageMode           = 0x02;
+  constexpr int8_t c_cmdColumnAddr      = 0x21;
+  constexpr int8_t c_cmdPageAddr        = 0x22;
 
   constexpr int8_t c_cmdSegRemap        = 0xa0;
   constexpr int8_t c_cmdComScan         = 0xc0;
@@ -46,6 +50,9 @@ namespace {
   };
 
   void sendSpi(SpiCommandOrData cmdOrData, int8_t* bytes, size_t len) {
+    // SPI is gated while we sleep.
+    g_power.require(PeriphSpi);
+
     // Command == DC pin LOW, data == DC pin HIGH.
     digitalWrite(c_dataCommandPin, cmdOrData == SpiCommand ? LOW : HIGH);
 
@@ -73,6 +80,11 @@ namespace {
     int8_t bytes[2] = { byte0, byte1 };
     sendSpi(SpiCommand, bytes, 2);
   }
+
+  void sendSpi(int8_t byte0, int8_t byte1, int8_t byte2) {
+    int8_t bytes[3] = { byte0, byte1, byte2 };
+    sendSpi(SpiCommand, bytes, 3);
+  }
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -97,9 +109,8 @@ void SSD1306::initialise() {
   // Initialise SPI.
   SPI.begin();
 
-  turnOff();                                       // Disable display.
+  turnOff();                                       // Disable display and charge pump.
 
-  sendSpi(c_cmdSetChargePump, c_chargePumpEnable); // Enable internal voltage charge pump.
   sendSpi(c_cmdSetDivideRatio, 0x80);              // Defaults to 1 but 0x80 seems to be the go.
   sendSpi(c_cmdSetPreCharge, 0xf1);                // Pre-charge period, phase 1 == 1, phase 2 == 15.
   sendSpi(c_cmdSetCompPins, 0x12);                 // Alternative COM pins, disable left/right remap.
@@ -112,18 +123,32 @@ void SSD1306::initialise() {
   setContrast(0xffu);                              // Full brightness.
 
   sendSpi(c_cmdDisplayResume);                     // Map from the internal buffer.
-  turnOn();                                        // Enable display.
+  turnOn();                                        // Enable charge pump and display.
 }
 
 // -------------------------------------------------------------------------------------------------
-// Turn display off (sleep mode) or back on.
-
-void SSD1306::turnOff() const {
+// Turn display off (sleep mode) or back on.  The internal charge pump is only needed to drive the
+// panel so it's disabled while the display is off.  The display RAM is kept either way.
+//
+// We sleep with the display already off after most wakes, so these skip the commands, and with them
+// waking SPI, when there's nothing to change.
+
+void SSD1306::turnOff() {
+  if (!m_isOn) {
+    return;
+  }
   sendSpi(c_cmdDisplayOff);
+  sendSpi(c_cmdSetChargePump, c_chargePumpDisable);
+  m_isOn = false;
 }
 
-void SSD1306::turnOn() const {
+void SSD1306::turnOn() {
+  if (m_isOn) {
+    return;
+  }
+  sendSpi(c_cmdSetChargePump, c_chargePumpEnable);
   sendSpi(c_cmdDisplayOn);
+  m_isOn = true;
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -148,9 +173,31 @@ void SSD1306::clear(int8_t val /*= 0*/) {
 }
 
 void SSD1306::flush() const {
+  // Reset the address window in case a region was flushed since.
+  sendSpi(c_cmdColumnAddr, 0, 127);
+  sendSpi(c_cmdPageAddr, 0, 7);
   sendSpi(SpiData, m_buffer, 1024);
 }
 
+// -------------------------------------------------------------------------------------------------
+// Clear or flush just the columns left to right (inclusive) of pages topPage to bottomPage
+// (inclusive).  A page is a band of 8 rows, so y / 8.  Flushing a region sets the display's address
+// window to it, so only those bytes need sending.
+
+void SSD1306::clearRegion(int8_t left, int8_t right, int8_t topPage, int8_t bottomPage) {
+  for (int8_t page = topPage; page <= bottomPage; page++) {
+    memset(&m_buffer[(page * 128) + left], 0, right - left + 1);
+  }
+}
+
+void SSD1306::flushRegion(int8_t left, int8_t right, int8_t topPage, int8_t bottomPage) const {
+  sendSpi(c_cmdColumnAddr, left, right);
+  sendSpi(c_cmdPageAddr, topPage, bottomPage);
+  for (int8_t page = topPage; page <= bottomPage; page++) {
+    sendSpi(SpiData, &m_buffer[(page * 128) + left], right - left + 1);
+  }
+}
+
 // -------------------------------------------------------------------------------------------------
 // Set a pixel in the backing buffer.  Must be 0 < x < 128 and 0 < y < 64.
 
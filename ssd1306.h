@@ -6,8 +6,8 @@ struct SSD1306 {
 
   void initialise();
 
-  void turnOff() const;
-  void turnOn() const;
+  void turnOff();
+  void turnOn();
 
   void nonInvert() const;
   void invert() const;
@@ -16,10 +16,15 @@ struct SSD1306 {
   void clear(int8_t val = 0);
   void flush() const;
 
+  void clearRegion(int8_t left, int8_t right, int8_t topPage, int8_t bottomPage);
+  void flushRegion(int8_t left, int8_t right, int8_t topPage, int8_t bottomPage) const;
+
   void setPixel(int8_t x, int8_t y);
 
   private:
 
   static uint8_t m_buffer[1024];
+
+  bool m_isOn = true;           // Unknown before initialise(), so assume on and send the commands.
 };
 
@@ -0,0 +1,89 @@
+#include <Arduino.h>
+
+#include <util/atomic.h>
+
+#include "stopwatch.h"
+
+#include "power.h"
+
+// -------------------------------------------------------------------------------------------------
+
+namespace {
+
+  constexpr uint8_t c_ticksPerSecond = 100;
+  constexpr uint8_t c_ticksPerFrame = 4;            // 25fps.
+
+  volatile uint32_t g_centis = 0;
+  volatile uint8_t g_frameTicks = 0;
+  volatile bool g_frameDue = false;
+
+  bool g_running = false;
+}
+
+ISR(TIMER1_COMPA_vect) {
+  g_centis++;
+  if (++g_frameTicks == c_ticksPerFrame) {
+    g_frameTicks = 0;
+    g_frameDue = true;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void startStopwatch() {
+  if (g_running) {
+    return;
+  }
+  g_power.require(PeriphTimer1);
+
+  // CTC mode, clk/64, compare match A at 100Hz.  This replaces the PWM setup Arduino gives Timer1,
+  // which is fine as we don't use PWM on pins 9 or 10.
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TCNT1 = 0;
+  OCR1A = (F_CPU / 64 / c_ticksPerSecond) - 1;
+  TIFR1 = bit(OCF1A);
+  TIMSK1 = bit(OCIE1A);
+  TCCR1B = bit(WGM12) | bit(CS11) | bit(CS10);
+
+  g_running = true;
+}
+
+void stopStopwatch() {
+  // Stop the clock, Timer1 is gated again when we next sleep.
+  TCCR1B = 0;
+  TIMSK1 = 0;
+  g_frameDue = false;
+  g_running = false;
+}
+
+void resetStopwatch() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    g_centis = 0;
+    g_frameTicks = 0;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool isStopwatchRunning() {
+  return g_running;
+}
+
+uint32_t getStopwatchCentis() {
+  uint32_t centis;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    centis = g_centis;
+  }
+  return centis;
+}
+
+bool takeStopwatchFrame() {
+  if (!g_frameDue) {
+    return false;
+  }
+  g_frameDue = false;
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------------
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+// -------------------------------------------------------------------------------------------------
+// A stopwatch counting centiseconds off a 100Hz Timer1 interrupt, which also paces the display
+// frames.  Nothing needs to poll millis() to keep time.
+
+void startStopwatch();
+void stopStopwatch();
+void resetStopwatch();
+
+bool isStopwatchRunning();
+uint32_t getStopwatchCentis();
+
+// True once per frame period while running, i.e., it's time to draw.
+bool takeStopwatchFrame();
+
+// -------------------------------------------------------------------------------------------------
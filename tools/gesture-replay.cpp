@@ -0,0 +1,84 @@
+// -------------------------------------------------------------------------------------------------
+// Replay accelerometer traces through the wrist raise classifier on the host.
+//
+// Traces are CSV, one raw x,y,z sample per line at 20Hz and +/-2g, as read from the IMU FIFO.
+// Blank lines and lines starting with # are skipped.  Build and run from the sketch directory:
+//
+//   g++ -std=gnu++11 -Wall -Wextra -I. tools/gesture-replay.cpp gesture.cpp -o gesture-replay
+//   ./gesture-replay tools/traces/*.csv
+//
+// Traces named raise-* are expected to contain at least one raise and all others none.  Exits
+// non-zero if any trace doesn't match.
+// -------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+#include "gesture.h"
+
+// -------------------------------------------------------------------------------------------------
+
+int replayTrace(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (file == nullptr) {
+    fprintf(stderr, "%s: can't open\n", path);
+    return -1;
+  }
+
+  WristRaiseClassifier classifier;
+  classifier.reset();
+
+  int raises = 0;
+  int sampleIdx = 0;
+  char line[128];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+      continue;
+    }
+
+    int x, y, z;
+    if (sscanf(line, "%d,%d,%d", &x, &y, &z) != 3) {
+      fprintf(stderr, "%s: bad sample '%s'\n", path, line);
+      fclose(file);
+      return -1;
+    }
+
+    AccelSample sample = { static_cast<int16_t>(x), static_cast<int16_t>(y),
+                           static_cast<int16_t>(z) };
+    if (classifier.feed(sample)) {
+      printf("%s: raise at sample %d\n", path, sampleIdx);
+      raises++;
+    }
+    sampleIdx++;
+  }
+
+  fclose(file);
+  return raises;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <trace.csv>...\n", argv[0]);
+    return 2;
+  }
+
+  int failures = 0;
+  for (int argIdx = 1; argIdx < argc; argIdx++) {
+    const char* path = argv[argIdx];
+    const char* name = strrchr(path, '/');
+    name = name != nullptr ? name + 1 : path;
+    bool expectRaise = strncmp(name, "raise-", 6) == 0;
+
+    int raises = replayTrace(path);
+    bool pass = raises >= 0 && (expectRaise ? raises > 0 : raises == 0);
+    printf("%s: %d raise(s), %s\n", path, raises < 0 ? 0 : raises, pass ? "ok" : "FAIL");
+    if (!pass) {
+      failures++;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+// -------------------------------------------------------------------------------------------------
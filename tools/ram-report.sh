@@ -0,0 +1,58 @@
+#!/bin/sh
+# -------------------------------------------------------------------------------------------------
+# Print the static RAM (.data, .bss and .noinit) each module uses, largest first, from the linker
+# map.  The AVR core builds with -flto, which merges everything into ltrans objects before linking,
+# so build without it and with a map, then point this at the map:
+#
+#   arduino-cli compile -b arduino:avr:leonardo --build-path build \
+#     --build-property "compiler.c.extra_flags=-fno-lto" \
+#     --build-property "compiler.cpp.extra_flags=-fno-lto" \
+#     --build-property "compiler.S.extra_flags=-fno-lto" \
+#     --build-property "compiler.c.elf.extra_flags=-fno-lto -Wl,-Map,{build.path}/{build.project_name}.map" .
+#   tools/ram-report.sh build/sio4.ino.map
+# -------------------------------------------------------------------------------------------------
+
+if [ $# -ne 1 ] || [ ! -f "$1" ]; then
+  echo "usage: $0 <linker map>" >&2
+  exit 1
+fi
+
+awk '
+  function hex(str,    idx, val) {
+    str = tolower(substr(str, 3))
+    val = 0
+    for (idx = 1; idx <= length(str); idx++) {
+      val = val * 16 + index("0123456789abcdef", substr(str, idx, 1)) - 1
+    }
+    return val
+  }
+
+  function add(size, file) {
+    sub(/.*\//, "", file)
+    if (file ~ /ltrans/) { lto = 1 }
+    bytes[file] += hex(size)
+  }
+
+  # Skip the discarded sections listed before the memory map proper.
+  /^Linker script and memory map/ { inMap = 1; next }
+  !inMap { next }
+
+  # Input sections are " .bss.name 0xaddr 0xsize file", or with a long name just " .bss.name" and
+  # the rest on the following line.
+  pending && NF == 3 && $1 ~ /^0x/ { add($2, $3); pending = 0; next }
+  { pending = 0 }
+  /^ (\.data|\.bss|\.noinit|COMMON)/ {
+    if (NF == 1) { pending = 1 } else if (NF == 4) { add($3, $4) }
+  }
+
+  END {
+    if (lto) {
+      print "warning: built with LTO, most RAM is attributed to ltrans objects" > "/dev/stderr"
+    }
+    for (file in bytes) {
+      if (bytes[file] > 0) { printf "%6d  %s\n", bytes[file], file; total += bytes[file] }
+    }
+    # Always the largest, so it sorts to the top.
+    printf "%6d  total\n", total
+  }
+' "$1" | sort -rn